@@ -25,6 +25,8 @@ module advanced_order_book
       character(kind=c_char) :: side
       integer(c_int) :: timestamp
       integer(c_int) :: order_type  ! New field for order type
+      integer(c_int) :: participant ! 0 = anonymous
+      integer(c_int) :: is_quote    ! 1 = resting leg of a two-sided quote
   end type order
 
   type, bind(C) :: instrument_book
@@ -35,11 +37,32 @@ module advanced_order_book
       integer(c_int) :: trade_count
   end type instrument_book
 
-  type(instrument_book), dimension(max_instruments), save, bind(C) :: books
+  ! The pools start out in static storage; attach_engine_memory() can move
+  ! them onto a huge-page mapping before any orders arrive. `books` is bound
+  ! on first use (see use_pools) because gfortran ignores array pointer
+  ! initialization in modules.
+  type(instrument_book), dimension(max_instruments), save, target :: static_books
+  type(instrument_book), dimension(:), pointer, contiguous :: books => null()
 
   integer(c_int), save, bind(C) :: instrument_count = 0
   integer(c_int), save, bind(C) :: global_trade_id = 0
 
+  ! Log levels and format ids, mirrored from fast_log.h
+  integer(c_int), parameter :: LOG_DEBUG = 0, LOG_INFO = 1, LOG_WARN = 2, LOG_ERROR = 3
+  integer(c_int), parameter :: LOG_FMT_INSTRUMENT_LOOKUP = 1, LOG_FMT_INSTRUMENT_FOUND = 2, &
+                               LOG_FMT_INSTRUMENT_CREATED = 3, LOG_FMT_INSTRUMENT_LIMIT = 4, &
+                               LOG_FMT_EMPTY_SYMBOL = 5
+
+  interface
+     subroutine fast_log_record(level, fmt_id, symbol, i0, i1, d0) bind(C, name="fast_log_record")
+       import :: c_int, c_char, c_long_long, c_double
+       integer(c_int), value :: level, fmt_id
+       character(kind=c_char), intent(in) :: symbol(*)
+       integer(c_long_long), value :: i0, i1
+       real(c_double), value :: d0
+     end subroutine fast_log_record
+  end interface
+
 contains
 
   function cchar_to_string(arr) result(str)
@@ -53,34 +76,59 @@ contains
       end do
   end function cchar_to_string
 
-  function find_instrument_index(symbol) result(idx)
+  subroutine use_pools()
+    if (.not. associated(books)) books => static_books
+  end subroutine use_pools
+
+  ! Like find_instrument_index, but returns -1 for an unknown symbol instead
+  ! of creating a slot for it.
+  function lookup_instrument_index(symbol) result(idx)
     character(kind=c_char), intent(in) :: symbol(*)
     integer(c_int) :: idx
     integer :: i
     character(len=8) :: sym_fortran, temp_str
 
+    call use_pools()
     sym_fortran = ''
     do i = 1, 8
         if (symbol(i) == c_null_char) exit
         sym_fortran(i:i) = symbol(i)
     end do
     sym_fortran = trim(adjustl(sym_fortran))
-    print *, "DEBUG: looking for symbol [", trim(sym_fortran), "]"
+    call fast_log_record(LOG_DEBUG, LOG_FMT_INSTRUMENT_LOOKUP, sym_fortran, 0_c_long_long, 0_c_long_long, 0.0d0)
     if (len_trim(sym_fortran) == 0) then
-        print *, "Error: empty symbol"
+        call fast_log_record(LOG_ERROR, LOG_FMT_EMPTY_SYMBOL, sym_fortran, 0_c_long_long, 0_c_long_long, 0.0d0)
         idx = -1
         return
     end if
     do i = 1, instrument_count
         temp_str = cchar_to_string(books(i)%symbol)
         temp_str = trim(adjustl(temp_str))
-        print *, "DEBUG: comparing with [", trim(temp_str), "]"
         if (trim(temp_str) == trim(sym_fortran)) then
             idx = i
-            print *, "DEBUG: found match at index", i
+            call fast_log_record(LOG_DEBUG, LOG_FMT_INSTRUMENT_FOUND, sym_fortran, &
+                                 int(i, c_long_long), 0_c_long_long, 0.0d0)
             return
         end if
     end do
+    idx = -1
+  end function lookup_instrument_index
+
+  function find_instrument_index(symbol) result(idx)
+    character(kind=c_char), intent(in) :: symbol(*)
+    integer(c_int) :: idx
+    integer :: i
+    character(len=8) :: sym_fortran
+
+    idx = lookup_instrument_index(symbol)
+    if (idx /= -1) return
+    sym_fortran = ''
+    do i = 1, 8
+        if (symbol(i) == c_null_char) exit
+        sym_fortran(i:i) = symbol(i)
+    end do
+    sym_fortran = trim(adjustl(sym_fortran))
+    if (len_trim(sym_fortran) == 0) return
     if (instrument_count < max_instruments) then
         instrument_count = instrument_count + 1
         do i = 1, len_trim(sym_fortran)
@@ -92,9 +140,10 @@ contains
         books(instrument_count)%order_count = 0
         books(instrument_count)%trade_count = 0
         idx = instrument_count
-        print *, "Created new instrument slot for [", trim(sym_fortran), "] at index", idx
+        call fast_log_record(LOG_INFO, LOG_FMT_INSTRUMENT_CREATED, sym_fortran, &
+                             int(idx, c_long_long), 0_c_long_long, 0.0d0)
     else
-        print *, "Instrument limit reached for symbol [", trim(sym_fortran), "]"
+        call fast_log_record(LOG_WARN, LOG_FMT_INSTRUMENT_LIMIT, sym_fortran, 0_c_long_long, 0_c_long_long, 0.0d0)
         idx = -1
     end if
   end function find_instrument_index
@@ -202,13 +251,66 @@ contains
       end if
   end subroutine match_order
 
+  subroutine place_order(idx, id, sym_fortran, price, quantity, side, order_type, participant, is_quote)
+      integer(c_int), value :: idx, id, quantity, order_type, participant, is_quote
+      character(len=8), intent(in) :: sym_fortran
+      real(c_double), value :: price
+      character(kind=c_char), value :: side
+      type(order) :: o
+
+      o%id = id
+      o%symbol = sym_fortran
+      o%price = price
+      o%quantity = quantity
+      o%side = side
+      o%timestamp = 0
+      o%order_type = order_type
+      o%participant = participant
+      o%is_quote = is_quote
+      call match_order(idx, o)
+  end subroutine place_order
+
+  ! Removes every resting order that matches the filter in a single pass.
+  ! participant < 0 and side ' ' act as wildcards.
+  function remove_orders(idx, participant, side, min_price, max_price, quotes_only) result(removed)
+      integer(c_int), value :: idx, participant, quotes_only
+      character(kind=c_char), value :: side
+      real(c_double), value :: min_price, max_price
+      integer(c_int) :: removed
+      integer :: i, kept
+      logical :: hit
+
+      kept = 0
+      do i = 1, books(idx)%order_count
+          hit = (participant < 0 .or. books(idx)%orders(i)%participant == participant) .and. &
+                (side == ' ' .or. side == c_null_char .or. books(idx)%orders(i)%side == side) .and. &
+                books(idx)%orders(i)%price >= min_price .and. books(idx)%orders(i)%price <= max_price .and. &
+                (quotes_only == 0 .or. books(idx)%orders(i)%is_quote == 1)
+          if (.not. hit) then
+              kept = kept + 1
+              if (kept /= i) books(idx)%orders(kept) = books(idx)%orders(i)
+          end if
+      end do
+      removed = books(idx)%order_count - kept
+      books(idx)%order_count = kept
+  end function remove_orders
+
   subroutine add_order(id, symbol, price, quantity, side, order_type) bind(C, name="add_order")
       integer(c_int), value :: id, quantity, order_type
       character(kind=c_char), intent(in) :: symbol(*)
       real(c_double), value :: price
       character(kind=c_char), value :: side
+
+      call add_participant_order(id, symbol, price, quantity, side, order_type, 0_c_int)
+  end subroutine add_order
+
+  subroutine add_participant_order(id, symbol, price, quantity, side, order_type, participant) &
+          bind(C, name="add_participant_order")
+      integer(c_int), value :: id, quantity, order_type, participant
+      character(kind=c_char), intent(in) :: symbol(*)
+      real(c_double), value :: price
+      character(kind=c_char), value :: side
       integer(c_int) :: idx
-      type(order) :: o
       character(len=8) :: sym_fortran
       integer :: i
 
@@ -218,20 +320,10 @@ contains
       end do
 
       idx = find_instrument_index(symbol)
-      if (idx == -1) then
-         print *, "Instrument limit reached or error for symbol [", trim(sym_fortran), "]"
-         return
-      end if
+      if (idx == -1) return
 
-      o%id = id
-      o%symbol = sym_fortran
-      o%price = price
-      o%quantity = quantity
-      o%side = side
-      o%timestamp = 0
-      o%order_type = order_type
-      call match_order(idx, o)
-  end subroutine add_order
+      call place_order(idx, id, sym_fortran, price, quantity, side, order_type, participant, 0_c_int)
+  end subroutine add_participant_order
 
   subroutine cancel_order(symbol, id, status) bind(C, name="cancel_order")
       character(kind=c_char), intent(in) :: symbol(*)
@@ -267,7 +359,7 @@ contains
       integer :: idx, i
       character(len=8) :: sym_fortran
       character(kind=c_char) :: side
-      integer(c_int) :: order_type
+      integer(c_int) :: order_type, participant, is_quote
 
       sym_fortran = ""
       do i = 1, 8
@@ -282,6 +374,8 @@ contains
           if (books(idx)%orders(i)%id == id) then
               side = books(idx)%orders(i)%side
               order_type = books(idx)%orders(i)%order_type
+              participant = books(idx)%orders(i)%participant
+              is_quote = books(idx)%orders(i)%is_quote
               books(idx)%orders(i) = books(idx)%orders(books(idx)%order_count)
               books(idx)%order_count = books(idx)%order_count - 1
               status = 0
@@ -290,10 +384,105 @@ contains
       end do
 
       if (status == 0) then
-         call add_order(id, symbol, new_price, new_quantity, side, order_type)
+         call place_order(idx, id, sym_fortran, new_price, new_quantity, side, order_type, participant, is_quote)
       end if
   end subroutine modify_order
 
+  ! Atomically replaces a participant's two-sided quote for one symbol. A side
+  ! with zero quantity is pulled. status: 0 = ok, 1 = no instrument (empty symbol
+  ! or instrument table full), 2 = crossed, 3 = participant not > 0 (0 is
+  ! anonymous, negative ids are wildcards), 4 = book full.
+  subroutine replace_quote(symbol, participant, bid_id, bid_price, bid_qty, ask_id, ask_price, ask_qty, status) &
+          bind(C, name="replace_quote")
+      character(kind=c_char), intent(in) :: symbol(*)
+      integer(c_int), value :: participant, bid_id, bid_qty, ask_id, ask_qty
+      real(c_double), value :: bid_price, ask_price
+      integer(c_int), intent(out) :: status
+      integer(c_int) :: idx, removed
+      character(len=8) :: sym_fortran
+      integer :: i, old_legs, new_legs
+
+      status = 1
+      if (participant <= 0) then
+         status = 3
+         return
+      end if
+      if (bid_qty > 0 .and. ask_qty > 0 .and. bid_price >= ask_price) then
+         status = 2
+         return
+      end if
+
+      sym_fortran = ""
+      do i = 1, 8
+         sym_fortran(i:i) = symbol(i)
+      end do
+
+      idx = find_instrument_index(symbol)
+      if (idx == -1) return
+
+      ! match_order drops a residual when the book is full, so make sure both
+      ! new legs could rest before touching the old quote. The old legs only
+      ! need counting when the book is nearly full.
+      new_legs = 0
+      if (bid_qty > 0) new_legs = new_legs + 1
+      if (ask_qty > 0) new_legs = new_legs + 1
+      if (books(idx)%order_count + new_legs > max_orders) then
+         old_legs = 0
+         do i = 1, books(idx)%order_count
+            if (books(idx)%orders(i)%participant == participant .and. books(idx)%orders(i)%is_quote == 1) &
+               old_legs = old_legs + 1
+         end do
+         if (books(idx)%order_count - old_legs + new_legs > max_orders) then
+            status = 4
+            return
+         end if
+      end if
+
+      removed = remove_orders(idx, participant, ' ', -huge(1.0d0), huge(1.0d0), 1_c_int)
+      if (bid_qty > 0) call place_order(idx, bid_id, sym_fortran, bid_price, bid_qty, 'B', ORDER_LIMIT, participant, 1_c_int)
+      if (ask_qty > 0) call place_order(idx, ask_id, sym_fortran, ask_price, ask_qty, 'S', ORDER_LIMIT, participant, 1_c_int)
+      status = 0
+  end subroutine replace_quote
+
+  ! Cancels every order matching participant (< 0 = any), side (' ' = both) and
+  ! the inclusive price range. A blank symbol applies to all instruments.
+  subroutine mass_cancel(symbol, participant, side, min_price, max_price, cancelled) bind(C, name="mass_cancel")
+      character(kind=c_char), intent(in) :: symbol(*)
+      integer(c_int), value :: participant
+      character(kind=c_char), value :: side
+      real(c_double), value :: min_price, max_price
+      integer(c_int), intent(out) :: cancelled
+      integer(c_int) :: idx
+
+      cancelled = 0
+      if (symbol(1) == ' ' .or. symbol(1) == c_null_char) then
+         do idx = 1, instrument_count
+            cancelled = cancelled + remove_orders(idx, participant, side, min_price, max_price, 0_c_int)
+         end do
+         return
+      end if
+
+      idx = lookup_instrument_index(symbol)
+      if (idx == -1) return
+      cancelled = remove_orders(idx, participant, side, min_price, max_price, 0_c_int)
+  end subroutine mass_cancel
+
+  ! Frees the slot of an instrument with no resting orders, dropping its
+  ! trade history. status: 0 = released, 1 = unknown symbol or orders still resting.
+  subroutine release_instrument(symbol, status) bind(C, name="release_instrument")
+      character(kind=c_char), intent(in) :: symbol(*)
+      integer(c_int), intent(out) :: status
+      integer(c_int) :: idx
+
+      status = 1
+      idx = lookup_instrument_index(symbol)
+      if (idx == -1) return
+      if (books(idx)%order_count > 0) return
+      if (idx /= instrument_count) books(idx) = books(instrument_count)
+      instrument_count = instrument_count - 1
+      status = 0
+  end subroutine release_instrument
+
   subroutine get_order_count(symbol, count) bind(C, name="get_order_count")
       character(kind=c_char), intent(in) :: symbol(*)
       integer(c_int), intent(out) :: count
@@ -366,5 +555,24 @@ contains
       end do
   end subroutine get_risk_metrics
 
+  subroutine get_engine_memory(base, bytes) bind(C, name="get_engine_memory")
+      type(c_ptr), intent(out) :: base
+      integer(c_size_t), intent(out) :: bytes
+      call use_pools()
+      base = c_loc(books(1))
+      bytes = max_instruments * c_sizeof(books(1))
+  end subroutine get_engine_memory
+
+  ! Copies the pools into `base` (at least get_engine_memory() bytes) and
+  ! uses that copy from then on. Must be called before other threads use the engine.
+  subroutine attach_engine_memory(base) bind(C, name="attach_engine_memory")
+      type(c_ptr), value :: base
+      type(instrument_book), dimension(:), pointer, contiguous :: pool
+      call use_pools()
+      call c_f_pointer(base, pool, [max_instruments])
+      pool = books
+      books => pool
+  end subroutine attach_engine_memory
+
 end module advanced_order_book
 
@@ -2,3 +2,8 @@ print("Running backtest script")
 -- add_order(id, symbol, price, quantity, side)
 add_order(201, "AAPL", 102.5, 15, "B")
 add_order(202, "AAPL", 103.0, 20, "S")
+-- replace_quote(participant, symbol, bid_id, bid_price, bid_qty, ask_id, ask_price, ask_qty)
+replace_quote(1, "AAPL", 301, 101.5, 10, 302, 102.0, 10)
+print("Quote " .. replace_quote(1, "AAPL", 303, 101.6, 10, 304, 102.1, 10))
+-- mass_cancel([participant], [symbol], [side], [min_price], [max_price])
+print("Cancelled " .. mass_cancel(1, "AAPL") .. " orders")
@@ -0,0 +1,21 @@
+// Engine-level driver for the quote benchmark, no HTTP server involved.
+// Usage: simulator_bench [n]
+#include "quote_benchmark.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    int n = 1000;
+    if (argc >= 2) {
+        n = std::atoi(argv[1]);
+        if (n <= 0) n = 1000;
+    }
+    QuoteBenchmarkResult r = run_quote_benchmark(n);
+    std::printf("%d quote updates: %.2f ms legacy vs %.2f ms replace_quote (%.1fx)\n",
+                r.quote_updates, r.legacy_quote_ms, r.replace_quote_ms,
+                r.replace_quote_ms > 0 ? r.legacy_quote_ms / r.replace_quote_ms : 0.0);
+    std::printf("%d cancels in batches of 80: %.2f ms legacy vs %.2f ms mass_cancel (%.1fx)\n",
+                r.orders_cancelled, r.legacy_cancel_ms, r.mass_cancel_ms,
+                r.mass_cancel_ms > 0 ? r.legacy_cancel_ms / r.mass_cancel_ms : 0.0);
+    return 0;
+}
@@ -0,0 +1,276 @@
+#include "fast_log.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// One record per cache line.
+struct alignas(64) LogRecord {
+    uint64_t ts_ns;
+    uint16_t fmt_id;
+    uint8_t level;
+    char side;
+    uint32_t reserved;
+    char symbol[8];
+    int64_t i[3];
+    double d[2];
+};
+static_assert(sizeof(LogRecord) == 64, "LogRecord must fill one cache line");
+
+static const size_t RING_CAPACITY = 4096; // power of two
+
+// Single-producer (owning thread) / single-consumer (writer thread) ring.
+struct LogBuffer {
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> retired{false};
+    LogRecord records[RING_CAPACITY];
+};
+
+static std::atomic<int> logLevel{LOG_OFF};
+static std::atomic<bool> logRunning{false};
+static std::mutex registryMutex;
+static std::vector<std::shared_ptr<LogBuffer>> registry;
+static std::thread writerThread;
+static std::FILE* logFile = nullptr;
+static std::chrono::steady_clock::time_point steadyBase;
+static std::chrono::system_clock::time_point wallBase;
+
+struct ThreadBufferHandle {
+    std::shared_ptr<LogBuffer> buf;
+    ~ThreadBufferHandle() {
+        if (buf) buf->retired.store(true, std::memory_order_release);
+    }
+};
+
+static uint64_t now_ns() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static LogBuffer* thread_buffer() {
+    static thread_local ThreadBufferHandle handle;
+    if (!handle.buf) {
+        handle.buf = std::make_shared<LogBuffer>();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(handle.buf);
+    }
+    return handle.buf.get();
+}
+
+void fast_log_event(int level, int fmt_id, const char* symbol,
+                    int64_t i0, int64_t i1, int64_t i2,
+                    double d0, double d1, char side) {
+    if (level < logLevel.load(std::memory_order_relaxed))
+        return;
+    LogBuffer* b = thread_buffer();
+    size_t head = b->head.load(std::memory_order_relaxed);
+    if (head - b->tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+        b->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    LogRecord &r = b->records[head & (RING_CAPACITY - 1)];
+    r.ts_ns = now_ns();
+    r.fmt_id = (uint16_t)fmt_id;
+    r.level = (uint8_t)level;
+    r.side = side;
+    std::memset(r.symbol, 0, sizeof(r.symbol));
+    if (symbol) {
+        for (int k = 0; k < 8 && symbol[k] != '\0'; k++)
+            r.symbol[k] = symbol[k];
+    }
+    r.i[0] = i0;
+    r.i[1] = i1;
+    r.i[2] = i2;
+    r.d[0] = d0;
+    r.d[1] = d1;
+    b->head.store(head + 1, std::memory_order_release);
+}
+
+extern "C" void fast_log_record(int level, int fmt_id, const char* symbol,
+                                long long i0, long long i1, double d0) {
+    fast_log_event(level, fmt_id, symbol, i0, i1, 0, d0);
+}
+
+extern "C" void fast_log_set_level(int level) {
+    if (level < LOG_DEBUG) level = LOG_DEBUG;
+    if (level > LOG_OFF) level = LOG_OFF;
+    logLevel.store(level, std::memory_order_relaxed);
+}
+
+extern "C" int fast_log_get_level(void) {
+    return logLevel.load(std::memory_order_relaxed);
+}
+
+const char* fast_log_level_name(int level) {
+    switch (level) {
+        case LOG_DEBUG: return "debug";
+        case LOG_INFO:  return "info";
+        case LOG_WARN:  return "warn";
+        case LOG_ERROR: return "error";
+        default:        return "off";
+    }
+}
+
+int fast_log_parse_level(const std::string &name) {
+    for (int l = LOG_DEBUG; l <= LOG_OFF; l++) {
+        if (name == fast_log_level_name(l))
+            return l;
+    }
+    return -1;
+}
+
+static void format_record(std::FILE* f, const LogRecord &r) {
+    char sym[9];
+    std::memcpy(sym, r.symbol, 8);
+    sym[8] = '\0';
+    for (int k = 7; k >= 0 && (sym[k] == ' ' || sym[k] == '\0'); k--)
+        sym[k] = '\0';
+
+    auto wall = wallBase + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds(r.ts_ns) - steadyBase.time_since_epoch());
+    std::time_t secs = std::chrono::system_clock::to_time_t(wall);
+    long micros = (long)(std::chrono::duration_cast<std::chrono::microseconds>(
+        wall.time_since_epoch()).count() % 1000000);
+    std::tm tm{};
+    localtime_r(&secs, &tm);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%H:%M:%S", &tm);
+    std::fprintf(f, "%s.%06ld %-5s ", stamp, micros, fast_log_level_name(r.level));
+
+    switch (r.fmt_id) {
+        case LOG_FMT_INSTRUMENT_LOOKUP:
+            std::fprintf(f, "looking for symbol [%s]\n", sym);
+            break;
+        case LOG_FMT_INSTRUMENT_FOUND:
+            std::fprintf(f, "found symbol [%s] at index %lld\n", sym, (long long)r.i[0]);
+            break;
+        case LOG_FMT_INSTRUMENT_CREATED:
+            std::fprintf(f, "created new instrument slot for [%s] at index %lld\n", sym, (long long)r.i[0]);
+            break;
+        case LOG_FMT_INSTRUMENT_LIMIT:
+            std::fprintf(f, "instrument limit reached for symbol [%s]\n", sym);
+            break;
+        case LOG_FMT_EMPTY_SYMBOL:
+            std::fprintf(f, "empty symbol\n");
+            break;
+        case LOG_FMT_ORDER_RECEIVED:
+            std::fprintf(f, "order received: symbol=%s id=%lld side=%c price=%.4f qty=%lld type=%lld\n",
+                         sym, (long long)r.i[0], r.side, r.d[0], (long long)r.i[1], (long long)r.i[2]);
+            break;
+        case LOG_FMT_MM_POSTED:
+            std::fprintf(f, "market maker posted %s: bid id=%lld @ %.4f, ask id=%lld @ %.4f\n",
+                         sym, (long long)r.i[0], r.d[0], (long long)r.i[1], r.d[1]);
+            break;
+        case LOG_FMT_FIX_LOGON:
+            std::fprintf(f, "FIX session logged on\n");
+            break;
+        case LOG_FMT_FIX_LOGOUT:
+            std::fprintf(f, "FIX session logged out\n");
+            break;
+        case LOG_FMT_FIX_NEW_ORDER:
+            std::fprintf(f, "processed FIX NewOrderSingle: symbol=%s id=%lld side=%c price=%.4f qty=%lld\n",
+                         sym, (long long)r.i[0], r.side, r.d[0], (long long)r.i[1]);
+            break;
+        case LOG_FMT_LEVEL_CHANGED:
+            std::fprintf(f, "log level set to %s\n", fast_log_level_name((int)r.i[0]));
+            break;
+        case LOG_FMT_RECORDS_DROPPED:
+            std::fprintf(f, "log buffer full, dropped %lld records\n", (long long)r.i[0]);
+            break;
+        case LOG_FMT_MASS_QUOTE:
+            std::fprintf(f, "mass quote: participant=%lld quotes=%lld\n", (long long)r.i[0], (long long)r.i[1]);
+            break;
+        case LOG_FMT_MASS_CANCEL:
+            std::fprintf(f, "mass cancel: symbol=%s participant=%lld side=%c price=[%.4f, %.4f] cancelled=%lld\n",
+                         sym[0] ? sym : "*", (long long)r.i[0], r.side, r.d[0], r.d[1], (long long)r.i[1]);
+            break;
+        default:
+            std::fprintf(f, "unknown format %u [%s] %lld %lld %lld %g %g\n", (unsigned)r.fmt_id, sym,
+                         (long long)r.i[0], (long long)r.i[1], (long long)r.i[2], r.d[0], r.d[1]);
+            break;
+    }
+}
+
+// Drains every registered ring, orders the batch by timestamp and writes it out.
+static size_t drain_all(std::vector<LogRecord> &batch) {
+    std::vector<std::shared_ptr<LogBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers = registry;
+    }
+    batch.clear();
+    for (auto &b : buffers) {
+        size_t tail = b->tail.load(std::memory_order_relaxed);
+        size_t head = b->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++)
+            batch.push_back(b->records[tail & (RING_CAPACITY - 1)]);
+        b->tail.store(tail, std::memory_order_release);
+        uint64_t dropped = b->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            LogRecord r{};
+            r.ts_ns = now_ns();
+            r.fmt_id = LOG_FMT_RECORDS_DROPPED;
+            r.level = LOG_WARN;
+            r.i[0] = (int64_t)dropped;
+            batch.push_back(r);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.erase(std::remove_if(registry.begin(), registry.end(),
+            [](const std::shared_ptr<LogBuffer> &b) {
+                return b->retired.load(std::memory_order_acquire) &&
+                       b->tail.load(std::memory_order_relaxed) == b->head.load(std::memory_order_acquire);
+            }), registry.end());
+    }
+    std::stable_sort(batch.begin(), batch.end(),
+        [](const LogRecord &a, const LogRecord &b) { return a.ts_ns < b.ts_ns; });
+    for (auto &r : batch)
+        format_record(logFile, r);
+    if (!batch.empty())
+        std::fflush(logFile);
+    return batch.size();
+}
+
+static void writer_loop() {
+    std::vector<LogRecord> batch;
+    batch.reserve(RING_CAPACITY);
+    while (logRunning.load(std::memory_order_acquire)) {
+        if (drain_all(batch) == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    drain_all(batch);
+}
+
+bool fast_log_start(const std::string &path, int level) {
+    if (logRunning.load())
+        return true;
+    logFile = path.empty() ? stdout : std::fopen(path.c_str(), "a");
+    if (!logFile)
+        return false;
+    steadyBase = std::chrono::steady_clock::now();
+    wallBase = std::chrono::system_clock::now();
+    logRunning.store(true, std::memory_order_release);
+    writerThread = std::thread(writer_loop);
+    fast_log_set_level(level);
+    return true;
+}
+
+void fast_log_stop() {
+    if (!logRunning.exchange(false))
+        return;
+    logLevel.store(LOG_OFF, std::memory_order_relaxed);
+    if (writerThread.joinable())
+        writerThread.join();
+    if (logFile && logFile != stdout)
+        std::fclose(logFile);
+    logFile = nullptr;
+}
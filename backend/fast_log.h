@@ -0,0 +1,60 @@
+#ifndef FAST_LOG_H
+#define FAST_LOG_H
+
+#include <cstdint>
+#include <string>
+
+// Asynchronous binary logger. Hot-path threads append fixed-size records
+// (format id + arguments) to a per-thread lock-free ring; a background
+// thread formats them and writes them to the log file.
+
+enum LogLevel {
+    LOG_DEBUG = 0,
+    LOG_INFO  = 1,
+    LOG_WARN  = 2,
+    LOG_ERROR = 3,
+    LOG_OFF   = 4
+};
+
+// Format ids. Values are shared with advanced_order_book.f90 - keep in sync.
+enum LogFormat {
+    LOG_FMT_INSTRUMENT_LOOKUP  = 1,  // symbol
+    LOG_FMT_INSTRUMENT_FOUND   = 2,  // symbol, i0 = index
+    LOG_FMT_INSTRUMENT_CREATED = 3,  // symbol, i0 = index
+    LOG_FMT_INSTRUMENT_LIMIT   = 4,  // symbol
+    LOG_FMT_EMPTY_SYMBOL       = 5,
+    LOG_FMT_ORDER_RECEIVED     = 6,  // symbol, i0 = id, i1 = qty, i2 = type, d0 = price, side
+    LOG_FMT_MM_POSTED          = 7,  // symbol, i0 = bid id, i1 = ask id, d0 = bid, d1 = ask
+    LOG_FMT_FIX_LOGON          = 8,
+    LOG_FMT_FIX_LOGOUT         = 9,
+    LOG_FMT_FIX_NEW_ORDER      = 10, // symbol, i0 = id, i1 = qty, d0 = price, side
+    LOG_FMT_LEVEL_CHANGED      = 11, // i0 = new level
+    LOG_FMT_RECORDS_DROPPED    = 12, // i0 = dropped record count
+    LOG_FMT_MASS_QUOTE         = 13, // i0 = participant, i1 = quote count
+    LOG_FMT_MASS_CANCEL        = 14  // symbol, i0 = participant, i1 = cancelled, d0/d1 = price range, side
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C ABI used by the Fortran engine. `symbol` is up to 8 chars, blank or NUL padded.
+void fast_log_record(int level, int fmt_id, const char* symbol,
+                     long long i0, long long i1, double d0);
+void fast_log_set_level(int level);
+int fast_log_get_level(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+bool fast_log_start(const std::string &path, int level);
+void fast_log_stop();
+int fast_log_parse_level(const std::string &name);
+const char* fast_log_level_name(int level);
+
+void fast_log_event(int level, int fmt_id, const char* symbol,
+                    int64_t i0 = 0, int64_t i1 = 0, int64_t i2 = 0,
+                    double d0 = 0.0, double d1 = 0.0, char side = 0);
+
+#endif // FAST_LOG_H
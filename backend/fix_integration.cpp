@@ -7,6 +7,7 @@
 #include "quickfix/FileLog.h"
 #include "quickfix/fix44/NewOrderSingle.h"
 #include "trading_engine.h"
+#include "fast_log.h"
 #include <iostream>
 #include <cstdlib>
 #include <string>
@@ -16,11 +17,11 @@ public:
     void onCreate(const FIX::SessionID&) override {}
 
     void onLogon(const FIX::SessionID&) override {
-        std::cout << "FIX session logged on" << std::endl;
+        fast_log_event(LOG_INFO, LOG_FMT_FIX_LOGON, nullptr);
     }
 
     void onLogout(const FIX::SessionID&) override {
-        std::cout << "FIX session logged out" << std::endl;
+        fast_log_event(LOG_INFO, LOG_FMT_FIX_LOGOUT, nullptr);
     }
 
     void toAdmin(FIX::Message&, const FIX::SessionID&) override {}
@@ -48,7 +49,7 @@ public:
         int id = std::atoi(clOrdID.getValue().c_str());
         std::string symStr = symbol.getValue();
         cpp_add_order(id, symStr, price, qty, sideChar, 0);
-        std::cout << "Processed FIX NewOrderSingle for symbol " << symStr << ": order id " << id << std::endl;
+        fast_log_event(LOG_INFO, LOG_FMT_FIX_NEW_ORDER, symStr.c_str(), id, (int)qty, 0, price, 0.0, sideChar);
     }
 };
 
@@ -58,6 +59,8 @@ int main(int argc, char** argv) {
             std::cerr << "Usage: simulator_fix <config_file>" << std::endl;
             return 1;
         }
+        const char* logFile = std::getenv("FLASH_LOG_FILE");
+        fast_log_start(logFile ? logFile : "simulator_fix.log", LOG_INFO);
         FIX::SessionSettings settings(argv[1]);
         FixApp application;
         FIX::FileStoreFactory storeFactory(settings);
@@ -69,8 +72,10 @@ int main(int argc, char** argv) {
         initiator.stop();
     } catch (std::exception &e) {
         std::cerr << "Exception: " << e.what() << std::endl;
+        fast_log_stop();
         return 1;
     }
+    fast_log_stop();
     return 0;
 }
 
@@ -1,7 +1,9 @@
 #include "lua.hpp"
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include "trading_engine.h"
+#include "fast_log.h"
 
 int lua_add_order(lua_State* L) {
     if (lua_gettop(L) < 5) {
@@ -19,15 +21,73 @@ int lua_add_order(lua_State* L) {
     if (lua_gettop(L) >= 6) {
         order_type = lua_tointeger(L, 6);
     }
-    cpp_add_order(id, std::string(symbol), price, quantity, side, order_type);
+    int participant = 0;
+    if (lua_gettop(L) >= 7) {
+        participant = lua_tointeger(L, 7);
+    }
+    if (participant < 0) {
+        lua_pushstring(L, "add_order participant must not be negative");
+        lua_error(L);
+        return 0;
+    }
+    cpp_add_order(id, std::string(symbol), price, quantity, side, order_type, participant);
     return 0;
 }
 
+// replace_quote(participant, symbol, bid_id, bid_price, bid_qty, ask_id, ask_price, ask_qty) -> status name
+int lua_replace_quote(lua_State* L) {
+    if (lua_gettop(L) < 8) {
+        lua_pushstring(L, "Not enough arguments to replace_quote");
+        lua_error(L);
+        return 0;
+    }
+    int participant = lua_tointeger(L, 1);
+    if (participant <= 0) {
+        lua_pushstring(L, "replace_quote participant must be positive");
+        lua_error(L);
+        return 0;
+    }
+    QuoteEntry quote;
+    const char* symbol = lua_tostring(L, 2);
+    quote.symbol = symbol ? symbol : "";
+    quote.bid_id = lua_tointeger(L, 3);
+    quote.bid_price = lua_tonumber(L, 4);
+    quote.bid_qty = lua_tointeger(L, 5);
+    quote.ask_id = lua_tointeger(L, 6);
+    quote.ask_price = lua_tonumber(L, 7);
+    quote.ask_qty = lua_tointeger(L, 8);
+    if (quote.symbol.empty() || quote.bid_qty < 0 || quote.ask_qty < 0 ||
+        (quote.bid_qty > 0 && quote.bid_price <= 0) ||
+        (quote.ask_qty > 0 && quote.ask_price <= 0)) {
+        lua_pushstring(L, "Invalid replace_quote values");
+        lua_error(L);
+        return 0;
+    }
+    lua_pushstring(L, cpp_quote_status_name(cpp_replace_quote(participant, quote)));
+    return 1;
+}
+
+// mass_cancel([participant], [symbol], [side], [min_price], [max_price]) -> cancelled
+// nil arguments match everything.
+int lua_mass_cancel(lua_State* L) {
+    int participant = lua_isnoneornil(L, 1) ? -1 : (int)lua_tointeger(L, 1);
+    std::string symbol = lua_isnoneornil(L, 2) ? "" : lua_tostring(L, 2);
+    char side = lua_isnoneornil(L, 3) ? 0 : lua_tostring(L, 3)[0];
+    double min_price = lua_isnoneornil(L, 4) ? 0.0 : lua_tonumber(L, 4);
+    double max_price = lua_isnoneornil(L, 5) ? 1e18 : lua_tonumber(L, 5);
+    lua_pushinteger(L, cpp_mass_cancel(symbol, participant, side, min_price, max_price));
+    return 1;
+}
+
 void registerLuaFunctions(lua_State* L) {
     lua_register(L, "add_order", lua_add_order);
+    lua_register(L, "replace_quote", lua_replace_quote);
+    lua_register(L, "mass_cancel", lua_mass_cancel);
 }
 
 int main(int argc, char** argv) {
+    const char* logFile = std::getenv("FLASH_LOG_FILE");
+    fast_log_start(logFile ? logFile : "simulator_lua.log", LOG_INFO);
     lua_State* L = luaL_newstate();
     luaL_openlibs(L);
     registerLuaFunctions(L);
@@ -35,6 +95,7 @@ int main(int argc, char** argv) {
         std::cerr << "Error running script: " << lua_tostring(L, -1) << std::endl;
     }
     lua_close(L);
+    fast_log_stop();
     return 0;
 }
 
@@ -0,0 +1,67 @@
+#include "quote_benchmark.h"
+#include "trading_engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+QuoteBenchmarkResult run_quote_benchmark(int n) {
+    const std::string symbol = QUOTE_BENCH_SYMBOL;
+    const int participant = QUOTE_BENCH_PARTICIPANT;
+    const int batch = 80; // stays well under the engine's 200-order book limit
+    int id = 2000000;
+    QuoteBenchmarkResult result{};
+    result.quote_updates = n;
+    cpp_mass_cancel(symbol, participant, 0, 0.0, 1e18);
+
+    int bidId = 0, askId = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        if (bidId) cpp_cancel_order(symbol, bidId);
+        if (askId) cpp_cancel_order(symbol, askId);
+        double mid = 100.0 + ((rand() % 100) / 10.0);
+        bidId = ++id;
+        askId = ++id;
+        cpp_add_order(bidId, symbol, mid - 0.5, 10, 'B', 0, participant);
+        cpp_add_order(askId, symbol, mid + 0.5, 10, 'S', 0, participant);
+    }
+    cpp_sync();
+    result.legacy_quote_ms = elapsed_ms(start);
+    cpp_mass_cancel(symbol, participant, 0, 0.0, 1e18);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        double mid = 100.0 + ((rand() % 100) / 10.0);
+        QuoteEntry quote{symbol, ++id, mid - 0.5, 10, ++id, mid + 0.5, 10};
+        cpp_replace_quote(participant, quote);
+    }
+    result.replace_quote_ms = elapsed_ms(start);
+    cpp_mass_cancel(symbol, participant, 0, 0.0, 1e18);
+
+    // Cancel phase: resting bids far from the market so nothing matches.
+    int rounds = std::max(1, n / batch);
+    for (int r = 0; r < rounds; r++) {
+        int first = id + 1;
+        for (int k = 0; k < batch; k++)
+            cpp_add_order(++id, symbol, 1.0 + k * 0.01, 1, 'B', 0, participant);
+        cpp_sync();
+        start = std::chrono::steady_clock::now();
+        for (int k = 0; k < batch; k++)
+            cpp_cancel_order(symbol, first + k);
+        result.legacy_cancel_ms += elapsed_ms(start);
+
+        for (int k = 0; k < batch; k++)
+            cpp_add_order(++id, symbol, 1.0 + k * 0.01, 1, 'B', 0, participant);
+        cpp_sync();
+        start = std::chrono::steady_clock::now();
+        cpp_mass_cancel(symbol, participant, 'B', 0.0, 2.0);
+        result.mass_cancel_ms += elapsed_ms(start);
+    }
+    result.orders_cancelled = rounds * batch;
+    cpp_release_instrument(symbol);
+    return result;
+}
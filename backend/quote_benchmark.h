@@ -0,0 +1,26 @@
+#ifndef QUOTE_BENCHMARK_H
+#define QUOTE_BENCHMARK_H
+
+#include <climits>
+
+// The quote benchmark runs on its own symbol with a reserved participant.
+// It is destructive: it mass-cancels that participant's QBENCH orders
+// before and after each phase, and frees the QBENCH instrument slot at the
+// end if nothing else rests there.
+#define QUOTE_BENCH_SYMBOL "QBENCH"
+const int QUOTE_BENCH_PARTICIPANT = INT_MAX;
+
+struct QuoteBenchmarkResult {
+    int quote_updates;
+    double legacy_quote_ms;
+    double replace_quote_ms;
+    int orders_cancelled;
+    double legacy_cancel_ms;
+    double mass_cancel_ms;
+};
+
+// Times n replace_quote calls against the cancel/cancel/add/add sequence they
+// replace, and mass_cancel against cancelling the same orders one by one.
+QuoteBenchmarkResult run_quote_benchmark(int n);
+
+#endif // QUOTE_BENCHMARK_H
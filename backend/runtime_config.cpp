@@ -0,0 +1,167 @@
+#include "runtime_config.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+extern "C" void get_engine_memory(void** base, size_t* bytes);
+extern "C" void attach_engine_memory(void* base);
+
+static std::string trim(const std::string &s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos)
+        return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+static std::vector<int> parse_cpu_list(const std::string &value) {
+    std::vector<int> cpus;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item = trim(item);
+        if (!item.empty())
+            cpus.push_back(std::atoi(item.c_str()));
+    }
+    return cpus;
+}
+
+bool load_runtime_config(const std::string &path, RuntimeConfig &cfg) {
+    std::ifstream in(path);
+    if (!in)
+        return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos)
+            line = line.substr(0, hash);
+        size_t eq = line.find('=');
+        if (eq == std::string::npos)
+            continue;
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        if (key == "low_latency")
+            cfg.low_latency = std::atoi(value.c_str()) != 0;
+        else if (key == "matcher_cpu")
+            cfg.matcher_cpu = std::atoi(value.c_str());
+        else if (key == "io_cpus")
+            cfg.io_cpus = parse_cpu_list(value);
+        else if (key == "publisher_cpus")
+            cfg.publisher_cpus = parse_cpu_list(value);
+        else if (key == "busy_poll")
+            cfg.busy_poll = std::atoi(value.c_str()) != 0;
+        else if (key == "lock_memory")
+            cfg.lock_memory = std::atoi(value.c_str()) != 0;
+        else if (key == "huge_pages")
+            cfg.huge_pages = std::atoi(value.c_str()) != 0;
+    }
+    return true;
+}
+
+bool pin_current_thread(int cpu) {
+    if (cpu < 0)
+        return false;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+bool pin_current_thread_round_robin(const std::vector<int> &cpus, std::atomic<unsigned> &next) {
+    if (cpus.empty())
+        return false;
+    return pin_current_thread(cpus[next.fetch_add(1) % cpus.size()]);
+}
+
+static void prefault(void* base, size_t bytes) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    volatile char* p = static_cast<volatile char*>(base);
+    for (size_t off = 0; off < bytes; off += page)
+        p[off] = p[off];
+}
+
+bool relocate_engine_pools(bool huge_pages) {
+    void* base = nullptr;
+    size_t bytes = 0;
+    get_engine_memory(&base, &bytes);
+    // Kept for the lifetime of the process.
+    void* pool = runtime_alloc(bytes, huge_pages);
+    if (!pool)
+        return false;
+    attach_engine_memory(pool);
+    return true;
+}
+
+bool lock_and_prefault_memory() {
+    void* base = nullptr;
+    size_t bytes = 0;
+    get_engine_memory(&base, &bytes);
+    prefault(base, bytes);
+    return runtime_lock(base, bytes);
+}
+
+bool runtime_lock(void* ptr, size_t bytes) {
+    return ptr && mlock(ptr, bytes) == 0;
+}
+
+static const size_t HUGE_PAGE_SIZE = 2u << 20;
+
+// Mappings are always rounded to 2MB so that runtime_free() does not need to
+// know whether the huge page request succeeded.
+static size_t mapping_length(size_t bytes) {
+    return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+}
+
+// Maps `len` bytes starting on a 2MB boundary, which transparent huge pages
+// need. Over-maps by 2MB and unmaps the slack on either side.
+static void* map_aligned(size_t len) {
+    size_t raw_len = len + HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, raw_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        return MAP_FAILED;
+    uintptr_t start = (uintptr_t)raw;
+    uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+    if (aligned > start)
+        munmap(raw, aligned - start);
+    size_t tail = (start + raw_len) - (aligned + len);
+    if (tail > 0)
+        munmap((void*)(aligned + len), tail);
+    return (void*)aligned;
+}
+
+void* runtime_alloc(size_t bytes, bool huge_pages) {
+    size_t len = mapping_length(bytes);
+    void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (huge_pages)
+        p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (p == MAP_FAILED) {
+        p = map_aligned(len);
+        if (p == MAP_FAILED)
+            return nullptr;
+#ifdef MADV_HUGEPAGE
+        if (huge_pages)
+            madvise(p, len, MADV_HUGEPAGE);
+#endif
+    }
+    prefault(p, len);
+    return p;
+}
+
+void runtime_free(void* ptr, size_t bytes) {
+    if (ptr)
+        munmap(ptr, mapping_length(bytes));
+}
@@ -0,0 +1,60 @@
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Startup configuration for the low-latency runtime mode. Loaded from a
+// key = value file, e.g.
+//
+//   low_latency    = 1
+//   matcher_cpu    = 2
+//   io_cpus        = 3,4
+//   publisher_cpus = 5
+//   busy_poll      = 1
+//   lock_memory    = 1
+//   huge_pages     = 1
+struct RuntimeConfig {
+    bool low_latency = false;
+    int matcher_cpu = -1;
+    std::vector<int> io_cpus;
+    std::vector<int> publisher_cpus;
+    bool busy_poll = false;
+    bool lock_memory = false;
+    bool huge_pages = false;
+};
+
+bool load_runtime_config(const std::string &path, RuntimeConfig &cfg);
+
+// Thread placement. Return false where affinity is unsupported (non-Linux).
+// Each CPU list needs its own counter so that one group of threads cannot
+// shift the round-robin position of another.
+bool pin_current_thread(int cpu);
+bool pin_current_thread_round_robin(const std::vector<int> &cpus, std::atomic<unsigned> &next);
+
+// Moves the Fortran order/trade pools onto a runtime_alloc() mapping. Call at
+// startup, before the matcher or any other engine thread is running.
+bool relocate_engine_pools(bool huge_pages);
+
+// Touches every page of the Fortran order/trade pools and mlock()s them.
+// Only the pools are locked, not the whole process, so this needs
+// RLIMIT_MEMLOCK (ulimit -l) of a few MB rather than unlimited.
+bool lock_and_prefault_memory();
+
+// Page-aligned allocation, backed by explicit huge pages when requested and
+// available. Memory is zeroed and prefaulted.
+void* runtime_alloc(size_t bytes, bool huge_pages);
+void runtime_free(void* ptr, size_t bytes);
+bool runtime_lock(void* ptr, size_t bytes);
+
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+#endif // RUNTIME_CONFIG_H
@@ -1,45 +1,94 @@
 // server.cpp
 #include "crow.h"
 #include "trading_engine.h"
+#include "fast_log.h"
+#include "runtime_config.h"
+#include "quote_benchmark.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <string>
 #include <sstream>
 #include <thread>
 #include <chrono>
 #include <iostream>
-#include <mutex>
+#include <atomic>
 #include <vector>
 
-std::mutex logMutex;
-void log_message(const std::string &msg) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    std::cout << msg << std::endl;
+static RuntimeConfig runtimeConfig;
+static std::atomic<unsigned> ioPinNext{0};
+static std::atomic<unsigned> publisherPinNext{0};
+static std::atomic<int> nextQuoteId{1000000};
+
+void addRandomOrder(const std::string &symbol) {
+    int orderId = rand() % 100000 + 30000;
+    double price = 100.0 + (rand() % 50);
+    int quantity = (rand() % 10) + 1;
+    char side = (rand() % 2) == 0 ? 'B' : 'S';
+    int orderType = (rand() % 2) == 0 ? 0 : 1; // 0 = limit, 1 = market
+    cpp_add_order(orderId, symbol, price, quantity, side, orderType);
 }
 
+// Throughput loop: orders are submitted back to back. The final cpp_sync()
+// waits for the matcher thread (if any) to finish this thread's orders.
 void placeRandomOrders(int n, const std::string &symbol) {
+    for (int i = 0; i < n; i++)
+        addRandomOrder(symbol);
+    cpp_sync();
+}
+
+// Latency pass, run after the throughput loop: each order is timed from
+// submit until the engine has processed it, one order in flight at a time.
+void sampleOrderLatency(int n, const std::string &symbol, std::vector<long> *latencies_ns) {
     for (int i = 0; i < n; i++) {
-        int orderId = rand() % 100000 + 30000;
-        double price = 100.0 + (rand() % 50);
-        int quantity = (rand() % 10) + 1;
-        char side = (rand() % 2) == 0 ? 'B' : 'S';
-        int orderType = (rand() % 2) == 0 ? 0 : 1; // 0 = limit, 1 = market
-        cpp_add_order(orderId, symbol, price, quantity, side, orderType);
+        auto start = std::chrono::steady_clock::now();
+        addRandomOrder(symbol);
+        cpp_sync();
+        auto end = std::chrono::steady_clock::now();
+        latencies_ns->push_back((long)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
     }
 }
 
-void marketMakerTask(const std::string &symbol) {
-    while (true) {
-        int buyId = rand() % 10000 + 1000;
-        double bidPrice = 100.0 + ((rand() % 100) / 10.0);
-        int buyQty = (rand() % 50) + 1;
-        cpp_add_order(buyId, symbol, bidPrice, buyQty, 'B', 0);
+// Adds latency percentiles and jitter (standard deviation) to a benchmark result.
+void addLatencyStats(std::vector<long> &latencies_ns, crow::json::wvalue &result) {
+    result["low_latency_mode"] = runtimeConfig.low_latency;
+    if (latencies_ns.empty())
+        return;
+    std::sort(latencies_ns.begin(), latencies_ns.end());
+    double sum = 0.0;
+    for (long l : latencies_ns) sum += l;
+    double mean = sum / latencies_ns.size();
+    double var = 0.0;
+    for (long l : latencies_ns) var += (l - mean) * (l - mean);
+    auto pct = [&](double p) {
+        size_t idx = (size_t)(p * (latencies_ns.size() - 1));
+        return latencies_ns[idx];
+    };
+    result["latency_mean_ns"] = mean;
+    result["latency_p50_ns"] = pct(0.50);
+    result["latency_p99_ns"] = pct(0.99);
+    result["latency_p999_ns"] = pct(0.999);
+    result["latency_max_ns"] = latencies_ns.back();
+    result["jitter_stddev_ns"] = std::sqrt(var / latencies_ns.size());
+}
 
-        int sellId = rand() % 10000 + 20000;
-        double askPrice = 100.0 + ((rand() % 100) / 10.0);
-        int sellQty = (rand() % 50) + 1;
-        cpp_add_order(sellId, symbol, askPrice, sellQty, 'S', 0);
+// Each cycle replaces the market maker's previous two-sided quote.
+void marketMakerTask(const std::string &symbol, int participant) {
+    pin_current_thread_round_robin(runtimeConfig.publisher_cpus, publisherPinNext);
+    while (true) {
+        double mid = 100.0 + ((rand() % 100) / 10.0);
+        QuoteEntry quote;
+        quote.symbol = symbol;
+        quote.bid_id = nextQuoteId.fetch_add(1);
+        quote.bid_price = mid - 0.05 * ((rand() % 5) + 1);
+        quote.bid_qty = (rand() % 50) + 1;
+        quote.ask_id = nextQuoteId.fetch_add(1);
+        quote.ask_price = mid + 0.05 * ((rand() % 5) + 1);
+        quote.ask_qty = (rand() % 50) + 1;
+        cpp_replace_quote(participant, quote);
 
-        log_message("MarketMaker posted orders for " + symbol);
+        fast_log_event(LOG_DEBUG, LOG_FMT_MM_POSTED, symbol.c_str(), quote.bid_id, quote.ask_id, 0,
+                       quote.bid_price, quote.ask_price);
         std::this_thread::sleep_for(std::chrono::seconds(3));
     }
 }
@@ -47,6 +96,13 @@ void marketMakerTask(const std::string &symbol) {
 struct CORSMiddleware {
     struct context {};
     void before_handle(crow::request& req, crow::response& res, context&) {
+        // Crow does not expose its worker threads, so each one pins itself on
+        // its first request.
+        static thread_local bool pinned = false;
+        if(!pinned) {
+            pin_current_thread_round_robin(runtimeConfig.io_cpus, ioPinNext);
+            pinned = true;
+        }
         if(req.method == crow::HTTPMethod::Options) {
             res.code = 204;
             res.end();
@@ -59,11 +115,42 @@ struct CORSMiddleware {
     }
 };
 
-int main() {
+int main(int argc, char** argv) {
+    const char* logFile = std::getenv("FLASH_LOG_FILE");
+    const char* logLevelEnv = std::getenv("FLASH_LOG_LEVEL");
+    int logLevel = logLevelEnv ? fast_log_parse_level(logLevelEnv) : LOG_INFO;
+    if (logLevel < 0) logLevel = LOG_INFO;
+    if (!fast_log_start(logFile ? logFile : "simulator.log", logLevel)) {
+        std::cerr << "Failed to open log file, logging disabled" << std::endl;
+    }
+
+    // Optional low-latency runtime mode: simulator <runtime_config_file>
+    if (argc >= 2) {
+        if (!load_runtime_config(argv[1], runtimeConfig)) {
+            std::cerr << "Could not read runtime config " << argv[1] << std::endl;
+            return 1;
+        }
+    }
+    if (!runtimeConfig.low_latency) {
+        // Mode off: ignore any placement settings in the file as well.
+        runtimeConfig = RuntimeConfig();
+    } else {
+        if (runtimeConfig.huge_pages && !relocate_engine_pools(true)) {
+            std::cerr << "Could not map the order pools; keeping static storage" << std::endl;
+        }
+        if (!cpp_start_matcher(runtimeConfig.matcher_cpu, runtimeConfig.busy_poll, runtimeConfig.huge_pages)) {
+            std::cerr << "Failed to start matching thread" << std::endl;
+            return 1;
+        }
+        if (runtimeConfig.lock_memory && !(lock_and_prefault_memory() && cpp_lock_matcher_memory())) {
+            std::cerr << "mlock failed (check ulimit -l); continuing with unlocked memory" << std::endl;
+        }
+    }
+
     // Start market-maker threads for AAPL and MSFT
-    std::thread mmAAPL(marketMakerTask, "AAPL");
+    std::thread mmAAPL(marketMakerTask, "AAPL", 1);
     mmAAPL.detach();
-    std::thread mmMSFT(marketMakerTask, "MSFT");
+    std::thread mmMSFT(marketMakerTask, "MSFT", 2);
     mmMSFT.detach();
 
     crow::App<CORSMiddleware> app;
@@ -90,7 +177,6 @@ int main() {
         if(req.method == crow::HTTPMethod::Options)
             return crow::response(204);
         try {
-            std::cout << "Received order request: " << req.body << std::endl;
             auto contentType = req.get_header_value("Content-Type");
             if(contentType.find("application/json") == std::string::npos) {
                 crow::json::wvalue error;
@@ -119,7 +205,8 @@ int main() {
             int quantity = order["quantity"].i();
             std::string side_str = order["side"].s();
             int order_type = order["order_type"].i();
-            if(symbol.empty() || price <= 0 || quantity <= 0 ||
+            int participant = order.has("participant") ? (int)order["participant"].i() : 0;
+            if(symbol.empty() || price <= 0 || quantity <= 0 || participant < 0 ||
                (side_str != "B" && side_str != "S")) {
                 crow::json::wvalue error;
                 error["status"] = "error";
@@ -127,7 +214,8 @@ int main() {
                 return crow::response(400, error);
             }
             char side = side_str[0];
-            cpp_add_order(id, symbol, price, quantity, side, order_type);
+            fast_log_event(LOG_INFO, LOG_FMT_ORDER_RECEIVED, symbol.c_str(), id, quantity, order_type, price, 0.0, side);
+            cpp_add_order(id, symbol, price, quantity, side, order_type, participant);
             crow::json::wvalue response;
             response["status"] = "success";
             response["order_id"] = id;
@@ -185,6 +273,97 @@ int main() {
         }
     });
 
+    // POST /mass_quote - replace one participant's two-sided quotes
+    // Body: {"participant":1,"quotes":[{"symbol":"AAPL","bid_id":1,"bid_price":99.5,"bid_qty":10,
+    //                                   "ask_id":2,"ask_price":100.5,"ask_qty":10}]}
+    CROW_ROUTE(app, "/mass_quote")
+    .methods(crow::HTTPMethod::Post, crow::HTTPMethod::Options)
+    ([](const crow::request& req) {
+        if(req.method == crow::HTTPMethod::Options)
+            return crow::response(204);
+        try {
+            auto body = crow::json::load(req.body);
+            if(!body)
+                return crow::response(400, "Invalid JSON");
+            if(!body.has("participant") || !body.has("quotes") ||
+               body["quotes"].t() != crow::json::type::List)
+                return crow::response(400, "Missing participant or quotes");
+            int participant = body["participant"].i();
+            if(participant <= 0)
+                return crow::response(400, "participant must be positive");
+            // Validate every entry before applying any, like /add_order.
+            // A quantity of 0 pulls that side; the other side needs a price > 0.
+            std::vector<QuoteEntry> quotes;
+            for (auto &q : body["quotes"]) {
+                if(q.t() != crow::json::type::Object ||
+                   !q.has("symbol") || !q.has("bid_id") || !q.has("bid_price") || !q.has("bid_qty") ||
+                   !q.has("ask_id") || !q.has("ask_price") || !q.has("ask_qty"))
+                    return crow::response(400, "Missing quote fields");
+                QuoteEntry entry;
+                entry.symbol = q["symbol"].s();
+                entry.bid_id = q["bid_id"].i();
+                entry.bid_price = q["bid_price"].d();
+                entry.bid_qty = q["bid_qty"].i();
+                entry.ask_id = q["ask_id"].i();
+                entry.ask_price = q["ask_price"].d();
+                entry.ask_qty = q["ask_qty"].i();
+                if(entry.symbol.empty() || entry.bid_qty < 0 || entry.ask_qty < 0 ||
+                   (entry.bid_qty > 0 && entry.bid_price <= 0) ||
+                   (entry.ask_qty > 0 && entry.ask_price <= 0))
+                    return crow::response(400, "Invalid field values");
+                quotes.push_back(entry);
+            }
+            auto statuses = cpp_mass_quote(participant, quotes);
+            fast_log_event(LOG_INFO, LOG_FMT_MASS_QUOTE, nullptr, participant, (int64_t)quotes.size());
+            crow::json::wvalue resp;
+            crow::json::wvalue::list results;
+            for (size_t i = 0; i < statuses.size(); i++) {
+                crow::json::wvalue item;
+                item["symbol"] = quotes[i].symbol;
+                item["status"] = cpp_quote_status_name(statuses[i]);
+                results.push_back(std::move(item));
+            }
+            resp["results"] = std::move(results);
+            return crow::response(resp);
+        } catch (std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    // POST /mass_cancel - cancel many orders in one pass
+    // Body (all optional): {"symbol":"AAPL","participant":1,"side":"B","min_price":99.0,"max_price":101.0}
+    CROW_ROUTE(app, "/mass_cancel")
+    .methods(crow::HTTPMethod::Post, crow::HTTPMethod::Options)
+    ([](const crow::request& req) {
+        if(req.method == crow::HTTPMethod::Options)
+            return crow::response(204);
+        try {
+            auto body = crow::json::load(req.body);
+            if(!body)
+                return crow::response(400, "Invalid JSON");
+            std::string symbol = body.has("symbol") ? std::string(body["symbol"].s()) : "";
+            int participant = body.has("participant") ? (int)body["participant"].i() : -1;
+            char side = 0;
+            if(body.has("side")) {
+                std::string side_str = body["side"].s();
+                if(side_str != "B" && side_str != "S")
+                    return crow::response(400, "Invalid side");
+                side = side_str[0];
+            }
+            double min_price = body.has("min_price") ? body["min_price"].d() : 0.0;
+            double max_price = body.has("max_price") ? body["max_price"].d() : 1e18;
+            int cancelled = cpp_mass_cancel(symbol, participant, side, min_price, max_price);
+            fast_log_event(LOG_INFO, LOG_FMT_MASS_CANCEL, symbol.c_str(), participant, cancelled, 0,
+                           min_price, max_price, side ? side : '*');
+            crow::json::wvalue resp;
+            resp["status"] = "success";
+            resp["cancelled"] = cancelled;
+            return crow::response(resp);
+        } catch (std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
     // GET /order_book
     CROW_ROUTE(app, "/order_book")
     .methods(crow::HTTPMethod::Get, crow::HTTPMethod::Options)
@@ -266,10 +445,14 @@ int main() {
         placeRandomOrders(n, symbol);
         auto end = std::chrono::high_resolution_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::vector<long> latencies;
+        latencies.reserve(n);
+        sampleOrderLatency(n, symbol, &latencies);
         crow::json::wvalue result;
         result["symbol"] = symbol;
         result["orders_placed"] = n;
         result["time_ms"] = (long)elapsed;
+        addLatencyStats(latencies, result);
         return crow::response(result);
     });
 
@@ -320,6 +503,73 @@ int main() {
         result["time_ms"] = (long)elapsed_ms;
         result["orders_per_sec"] = orders_per_sec;
         result["avg_time_per_order_ms"] = avg_time_per_order_ms;
+        std::vector<std::vector<long>> latencies(c);
+        {
+            std::vector<std::thread> threads;
+            threads.reserve(c);
+            for(int i = 0; i < c; i++) {
+                latencies[i].reserve(n);
+                threads.emplace_back(sampleOrderLatency, n, symbol, &latencies[i]);
+            }
+            for(auto &t : threads) {
+                t.join();
+            }
+        }
+        std::vector<long> all;
+        all.reserve(total_orders);
+        for(auto &l : latencies) all.insert(all.end(), l.begin(), l.end());
+        addLatencyStats(all, result);
+        return crow::response(result);
+    });
+
+    // GET /benchmark_quotes - replace_quote/mass_cancel vs. individual orders
+    // Usage: /benchmark_quotes?n=1000
+    // Always runs on QBENCH with a reserved participant and clears that
+    // participant's QBENCH orders.
+    CROW_ROUTE(app, "/benchmark_quotes")
+    .methods(crow::HTTPMethod::Get, crow::HTTPMethod::Options)
+    ([](const crow::request& req) {
+        if(req.method == crow::HTTPMethod::Options)
+            return crow::response(204);
+        if(req.url_params.get("symbol"))
+            return crow::response(400, "benchmark_quotes always runs on " QUOTE_BENCH_SYMBOL);
+        int n = 1000;
+        auto nParam = req.url_params.get("n");
+        if(nParam) {
+            n = std::atoi(nParam);
+            if(n <= 0) n = 1000;
+        }
+        QuoteBenchmarkResult r = run_quote_benchmark(n);
+        crow::json::wvalue result;
+        result["symbol"] = QUOTE_BENCH_SYMBOL;
+        result["quote_updates"] = r.quote_updates;
+        result["legacy_quote_ms"] = r.legacy_quote_ms;
+        result["replace_quote_ms"] = r.replace_quote_ms;
+        result["quote_speedup"] = r.replace_quote_ms > 0 ? r.legacy_quote_ms / r.replace_quote_ms : 0.0;
+        result["orders_cancelled"] = r.orders_cancelled;
+        result["legacy_cancel_ms"] = r.legacy_cancel_ms;
+        result["mass_cancel_ms"] = r.mass_cancel_ms;
+        result["cancel_speedup"] = r.mass_cancel_ms > 0 ? r.legacy_cancel_ms / r.mass_cancel_ms : 0.0;
+        return crow::response(result);
+    });
+
+    // GET /log_level - read or change the runtime log level
+    // Usage: /log_level?level=debug|info|warn|error|off
+    CROW_ROUTE(app, "/log_level")
+    .methods(crow::HTTPMethod::Get, crow::HTTPMethod::Options)
+    ([](const crow::request& req) {
+        if(req.method == crow::HTTPMethod::Options)
+            return crow::response(204);
+        auto levelParam = req.url_params.get("level");
+        if(levelParam) {
+            int level = fast_log_parse_level(levelParam);
+            if(level < 0)
+                return crow::response(400, "Invalid level param");
+            fast_log_set_level(level);
+            fast_log_event(LOG_INFO, LOG_FMT_LEVEL_CHANGED, nullptr, level);
+        }
+        crow::json::wvalue result;
+        result["level"] = fast_log_level_name(fast_log_get_level());
         return crow::response(result);
     });
 
@@ -332,6 +582,7 @@ int main() {
     .onmessage([](crow::websocket::connection& conn, const std::string& data, bool) {
          std::string symbol = data;
          std::thread([symbol, &conn]() {
+             pin_current_thread_round_robin(runtimeConfig.publisher_cpus, publisherPinNext);
              while (true) {
                  int count = cpp_get_order_count(symbol);
                  try {
@@ -347,7 +598,12 @@ int main() {
          // Handle WebSocket closure if needed.
     });
 
-    app.port(18080).multithreaded().run();
+    if (runtimeConfig.low_latency && !runtimeConfig.io_cpus.empty())
+        app.port(18080).concurrency((std::uint16_t)runtimeConfig.io_cpus.size()).run();
+    else
+        app.port(18080).multithreaded().run();
+    cpp_stop_matcher();
+    fast_log_stop();
     return 0;
 }
 
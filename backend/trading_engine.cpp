@@ -1,26 +1,197 @@
 #include "trading_engine.h"
+#include "runtime_config.h"
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 #include <vector>
 #include <tuple>
 
 static std::mutex fortranMutex;
 
+struct EngineCommand {
+    int id;
+    char sym[9];
+    double price;
+    int quantity;
+    char side;
+    int order_type;
+    int participant;
+};
+
+// Bounded MPSC queue (Vyukov-style cells with sequence numbers).
+struct alignas(64) CommandCell {
+    std::atomic<size_t> seq;
+    EngineCommand cmd;
+};
+
+// Power of two. Also bounds how much cpp_stop_matcher() has to drain.
+static const size_t QUEUE_CAPACITY = 1 << 12;
+static CommandCell* commandQueue = nullptr;
+alignas(64) static std::atomic<size_t> enqueuePos{0};
+alignas(64) static std::atomic<size_t> processedPos{0};
+// Producers that may still touch commandQueue; stop waits for this to reach 0.
+alignas(64) static std::atomic<int> activeProducers{0};
+static std::atomic<bool> matcherRunning{false};
+static std::atomic<bool> matcherExit{false};
+static std::atomic<bool> matcherSleeping{false};
+static bool matcherBusyPoll = false;
+static std::thread matcherThread;
+static std::mutex wakeMutex;
+static std::condition_variable wakeCv;
+// One past the queue position of this thread's last enqueued order.
+static thread_local size_t lastEnqueuedPos = 0;
+
 static void string_to_c8(const std::string &s, char sym[9]) {
     std::memset(sym, ' ', 8);
     sym[8] = '\0';
     std::strncpy(sym, s.c_str(), std::min((size_t)8, s.size()));
 }
 
-void cpp_add_order(int id, const std::string &symbol, double price, int quantity, char side, int order_type) {
+static void wait_for_matcher() {
+    if (!matcherRunning.load(std::memory_order_acquire))
+        return;
+    size_t target = enqueuePos.load(std::memory_order_acquire);
+    while (processedPos.load(std::memory_order_acquire) < target)
+        std::this_thread::yield();
+}
+
+// Returns the queue position the command was placed at.
+static size_t enqueue_command(const EngineCommand &cmd) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    CommandCell* cell;
+    for (;;) {
+        cell = &commandQueue[pos & (QUEUE_CAPACITY - 1)];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // Queue full: back off until the matcher catches up.
+            std::this_thread::yield();
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->cmd = cmd;
+    cell->seq.store(pos + 1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!matcherBusyPoll && matcherSleeping.load()) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeCv.notify_one();
+    }
+    return pos;
+}
+
+static void matcher_loop() {
+    size_t pos = processedPos.load(std::memory_order_relaxed);
+    for (;;) {
+        CommandCell* cell = &commandQueue[pos & (QUEUE_CAPACITY - 1)];
+        if (cell->seq.load(std::memory_order_acquire) != pos + 1) {
+            if (matcherExit.load(std::memory_order_acquire) &&
+                enqueuePos.load(std::memory_order_acquire) == pos)
+                break;
+            if (matcherBusyPoll) {
+                cpu_relax();
+            } else {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                matcherSleeping.store(true);
+                if (cell->seq.load() != pos + 1)
+                    wakeCv.wait_for(lock, std::chrono::milliseconds(1));
+                matcherSleeping.store(false);
+            }
+            continue;
+        }
+        // Drain a batch under a single lock acquisition.
+        std::lock_guard<std::mutex> lock(fortranMutex);
+        for (int n = 0; n < 64 && cell->seq.load(std::memory_order_acquire) == pos + 1; n++) {
+            EngineCommand &c = cell->cmd;
+            add_participant_order(c.id, c.sym, c.price, c.quantity, c.side, c.order_type, c.participant);
+            cell->seq.store(pos + QUEUE_CAPACITY, std::memory_order_release);
+            pos++;
+            processedPos.store(pos, std::memory_order_release);
+            cell = &commandQueue[pos & (QUEUE_CAPACITY - 1)];
+        }
+    }
+}
+
+bool cpp_start_matcher(int cpu, bool busy_poll, bool huge_pages) {
+    if (matcherRunning.load())
+        return true;
+    commandQueue = static_cast<CommandCell*>(runtime_alloc(sizeof(CommandCell) * QUEUE_CAPACITY, huge_pages));
+    if (!commandQueue)
+        return false;
+    size_t start = enqueuePos.load();
+    for (size_t i = 0; i < QUEUE_CAPACITY; i++)
+        commandQueue[(start + i) & (QUEUE_CAPACITY - 1)].seq.store(start + i, std::memory_order_relaxed);
+    processedPos.store(start);
+    matcherBusyPoll = busy_poll;
+    matcherExit.store(false);
+    matcherRunning.store(true, std::memory_order_release);
+    matcherThread = std::thread([cpu]() {
+        pin_current_thread(cpu);
+        matcher_loop();
+    });
+    return true;
+}
+
+// Stops admitting commands, waits for in-flight producers, then lets the
+// matcher drain what is already queued (at most QUEUE_CAPACITY orders).
+void cpp_stop_matcher() {
+    if (!matcherRunning.exchange(false))
+        return;
+    while (activeProducers.load() != 0)
+        std::this_thread::yield();
+    matcherExit.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeCv.notify_one();
+    }
+    if (matcherThread.joinable())
+        matcherThread.join();
+    runtime_free(commandQueue, sizeof(CommandCell) * QUEUE_CAPACITY);
+    commandQueue = nullptr;
+}
+
+bool cpp_lock_matcher_memory() {
+    return runtime_lock(commandQueue, sizeof(CommandCell) * QUEUE_CAPACITY);
+}
+
+void cpp_sync() {
+    while (processedPos.load(std::memory_order_acquire) < lastEnqueuedPos)
+        std::this_thread::yield();
+}
+
+void cpp_add_order(int id, const std::string &symbol, double price, int quantity, char side, int order_type,
+                   int participant) {
+    activeProducers.fetch_add(1);
+    if (matcherRunning.load()) {
+        EngineCommand cmd;
+        cmd.id = id;
+        string_to_c8(symbol, cmd.sym);
+        cmd.price = price;
+        cmd.quantity = quantity;
+        cmd.side = side;
+        cmd.order_type = order_type;
+        cmd.participant = participant;
+        lastEnqueuedPos = enqueue_command(cmd) + 1;
+        activeProducers.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+    activeProducers.fetch_sub(1, std::memory_order_release);
     std::lock_guard<std::mutex> lock(fortranMutex);
     char sym[9];
     string_to_c8(symbol, sym);
-    add_order(id, sym, price, quantity, side, order_type);
+    add_participant_order(id, sym, price, quantity, side, order_type, participant);
 }
 
 int cpp_cancel_order(const std::string &symbol, int id) {
+    wait_for_matcher();
     std::lock_guard<std::mutex> lock(fortranMutex);
     int status = 1;
     char sym[9];
@@ -30,6 +201,7 @@ int cpp_cancel_order(const std::string &symbol, int id) {
 }
 
 int cpp_modify_order(const std::string &symbol, int id, double new_price, int new_quantity) {
+    wait_for_matcher();
     std::lock_guard<std::mutex> lock(fortranMutex);
     int status = 1;
     char sym[9];
@@ -39,6 +211,7 @@ int cpp_modify_order(const std::string &symbol, int id, double new_price, int ne
 }
 
 int cpp_get_order_count(const std::string &symbol) {
+    wait_for_matcher();
     std::lock_guard<std::mutex> lock(fortranMutex);
     int count = 0;
     char sym[9];
@@ -48,6 +221,7 @@ int cpp_get_order_count(const std::string &symbol) {
 }
 
 std::vector<std::tuple<double,int,char>> cpp_get_order_book_snapshot(const std::string &symbol) {
+    wait_for_matcher();
     std::lock_guard<std::mutex> lock(fortranMutex);
     double prices[200];
     int qtys[200];
@@ -64,6 +238,7 @@ std::vector<std::tuple<double,int,char>> cpp_get_order_book_snapshot(const std::
 }
 
 std::vector<TradeData> cpp_get_trades(const std::string &symbol) {
+    wait_for_matcher();
     std::lock_guard<std::mutex> lock(fortranMutex);
     double prices[2000];
     int qtys[2000], tids[2000];
@@ -85,6 +260,7 @@ std::vector<TradeData> cpp_get_trades(const std::string &symbol) {
 }
 
 int cpp_get_risk_metrics(const std::string &symbol) {
+    wait_for_matcher();
     std::lock_guard<std::mutex> lock(fortranMutex);
     int total_qty = 0;
     char sym[9];
@@ -93,3 +269,63 @@ int cpp_get_risk_metrics(const std::string &symbol) {
     return total_qty;
 }
 
+const char* cpp_quote_status_name(int status) {
+    switch (status) {
+        case QUOTE_OK:                  return "success";
+        case QUOTE_NO_INSTRUMENT:       return "no_instrument";
+        case QUOTE_CROSSED:             return "crossed";
+        case QUOTE_INVALID_PARTICIPANT: return "invalid_participant";
+        case QUOTE_BOOK_FULL:           return "book_full";
+        default:                        return "error";
+    }
+}
+
+static int replace_quote_locked(int participant, const QuoteEntry &q) {
+    int status = 1;
+    char sym[9];
+    string_to_c8(q.symbol, sym);
+    replace_quote(sym, participant, q.bid_id, q.bid_price, q.bid_qty, q.ask_id, q.ask_price, q.ask_qty, &status);
+    return status;
+}
+
+int cpp_replace_quote(int participant, const QuoteEntry &quote) {
+    if (participant <= 0)
+        return QUOTE_INVALID_PARTICIPANT;
+    wait_for_matcher();
+    std::lock_guard<std::mutex> lock(fortranMutex);
+    return replace_quote_locked(participant, quote);
+}
+
+std::vector<int> cpp_mass_quote(int participant, const std::vector<QuoteEntry> &quotes) {
+    if (participant <= 0)
+        return std::vector<int>(quotes.size(), QUOTE_INVALID_PARTICIPANT);
+    wait_for_matcher();
+    std::lock_guard<std::mutex> lock(fortranMutex);
+    std::vector<int> statuses;
+    statuses.reserve(quotes.size());
+    for (const auto &q : quotes) {
+        statuses.push_back(replace_quote_locked(participant, q));
+    }
+    return statuses;
+}
+
+int cpp_mass_cancel(const std::string &symbol, int participant, char side,
+                    double min_price, double max_price) {
+    wait_for_matcher();
+    std::lock_guard<std::mutex> lock(fortranMutex);
+    int cancelled = 0;
+    char sym[9];
+    string_to_c8(symbol, sym);
+    mass_cancel(sym, participant, side == 0 ? ' ' : side, min_price, max_price, &cancelled);
+    return cancelled;
+}
+
+bool cpp_release_instrument(const std::string &symbol) {
+    wait_for_matcher();
+    std::lock_guard<std::mutex> lock(fortranMutex);
+    int status = 1;
+    char sym[9];
+    string_to_c8(symbol, sym);
+    release_instrument(sym, &status);
+    return status == 0;
+}
@@ -10,18 +10,24 @@ extern "C" {
 #endif
 
 void add_order(int id, const char* symbol, double price, int quantity, char side, int order_type);
+void add_participant_order(int id, const char* symbol, double price, int quantity, char side, int order_type, int participant);
 void cancel_order(const char* symbol, int id, int* status);
 void modify_order(const char* symbol, int id, double new_price, int new_quantity, int* status);
 void get_order_count(const char* symbol, int* count);
 void get_order_book_snapshot(const char* symbol, double* out_prices, int* out_qtys, char* out_sides, int* out_count);
 void get_trades(const char* symbol, double* out_prices, int* out_qtys, char* out_sides, int* out_tids, int* out_count);
 void get_risk_metrics(const char* symbol, int* total_qty);
+void replace_quote(const char* symbol, int participant, int bid_id, double bid_price, int bid_qty,
+                   int ask_id, double ask_price, int ask_qty, int* status);
+void mass_cancel(const char* symbol, int participant, char side, double min_price, double max_price, int* cancelled);
+void release_instrument(const char* symbol, int* status);
 
 #ifdef __cplusplus
 }
 #endif
 
-void cpp_add_order(int id, const std::string &symbol, double price, int quantity, char side, int order_type);
+void cpp_add_order(int id, const std::string &symbol, double price, int quantity, char side, int order_type,
+                   int participant = 0);
 int cpp_cancel_order(const std::string &symbol, int id);
 int cpp_modify_order(const std::string &symbol, int id, double new_price, int new_quantity);
 int cpp_get_order_count(const std::string &symbol);
@@ -37,5 +43,55 @@ struct TradeData {
 std::vector<TradeData> cpp_get_trades(const std::string &symbol);
 int cpp_get_risk_metrics(const std::string &symbol);
 
+// Two-sided quote. A side with zero quantity is pulled.
+struct QuoteEntry {
+    std::string symbol;
+    int bid_id;
+    double bid_price;
+    int bid_qty;
+    int ask_id;
+    double ask_price;
+    int ask_qty;
+};
+
+// Quote status codes, shared with replace_quote in advanced_order_book.f90.
+// Quotes need a participant > 0: 0 is anonymous and negative ids are
+// wildcards for mass cancel.
+enum QuoteStatus {
+    QUOTE_OK                  = 0,
+    QUOTE_NO_INSTRUMENT       = 1, // empty symbol or instrument table full
+    QUOTE_CROSSED             = 2,
+    QUOTE_INVALID_PARTICIPANT = 3,
+    QUOTE_BOOK_FULL           = 4  // no room for the new legs; the old quote is kept
+};
+
+// "success", "no_instrument", "crossed", "invalid_participant" or "book_full".
+const char* cpp_quote_status_name(int status);
+
+int cpp_replace_quote(int participant, const QuoteEntry &quote);
+std::vector<int> cpp_mass_quote(int participant, const std::vector<QuoteEntry> &quotes);
+
+// Cancels all matching orders in one pass and returns how many were removed.
+// participant < 0 matches anyone, side 0 matches both sides and an empty
+// symbol matches every instrument. An unknown symbol cancels nothing and
+// does not take an instrument slot.
+int cpp_mass_cancel(const std::string &symbol, int participant, char side,
+                    double min_price, double max_price);
+
+// Frees the instrument slot of a symbol with no resting orders (its trade
+// history is dropped). Returns false if the symbol is unknown or still has orders.
+bool cpp_release_instrument(const std::string &symbol);
+
+// Dedicated matching thread. While it runs, cpp_add_order enqueues onto a
+// lock-free command queue and the other calls wait for the queue to drain
+// before touching the book, so each caller still sees its own orders.
+bool cpp_start_matcher(int cpu, bool busy_poll, bool huge_pages);
+void cpp_stop_matcher();
+// mlock()s the command queue. Call after cpp_start_matcher.
+bool cpp_lock_matcher_memory();
+// Waits until the calling thread's last cpp_add_order has been matched.
+// Orders queued by other threads are not waited for.
+void cpp_sync();
+
 #endif // TRADING_ENGINE_H
 